@@ -0,0 +1,50 @@
+#!/bin/bash
+
+# usage: ./scripts/bench.sh [iterations]
+# requires local chain from `./scripts/restart.sh` & vault from `./scripts/test.sh`
+#
+# first call (instantiation) CPU is only cold when the deployed code hash is new to nodeos:
+# nodeos caches compiled modules by code hash & `cleos set contract` rejects identical code,
+# alternate `./scripts/build.sh` and `./scripts/build.sh size` (or change the source) before each run
+ITERATIONS=${1:-10}
+
+# warn when code hash did not change since previous run
+CODE_HASH=$(cleos get code vaults.sx | awk '{ print $3 }')
+mkdir -p ./nodeos
+if [ "$CODE_HASH" == "$(cat ./nodeos/bench_code_hash 2>/dev/null)" ]; then
+  echo "warning: code hash $CODE_HASH unchanged since previous run, first call is warm"
+fi
+echo $CODE_HASH > ./nodeos/bench_code_hash
+
+# print CPU usage (us) of transaction
+cpu() {
+  jq -r '.processed.receipt.cpu_usage_us'
+}
+
+# first call vs. warm
+FIRST=$(cleos push action vaults.sx update '["EOS"]' -p vaults.sx -f --json | cpu)
+WARM=$(cleos push action vaults.sx update '["EOS"]' -p vaults.sx -f --json | cpu)
+echo "update first: ${FIRST}us warm: ${WARM}us"
+
+# print min/avg/max of values
+summary() {
+  echo "$2" | awk -v name=$1 'NF { n++; s += $1; if ( n == 1 || $1 < min ) min = $1; if ( $1 > max ) max = $1 }
+    END { if ( n ) printf "%s: min %dus avg %.1fus max %dus (%d runs)\n", name, min, s / n, max, n }'
+}
+
+DEPOSITS=""
+REDEEMS=""
+for i in $(seq 1 $ITERATIONS); do
+  # deposit
+  DEPOSIT=$(cleos transfer account.sx vaults.sx "1.0000 EOS" "$i" --json | cpu)
+
+  # redeem
+  REDEEM=$(cleos transfer account.sx vaults.sx "10000.0000 SXEOS" "$i" --contract token.sx --json | cpu)
+
+  echo "deposit: ${DEPOSIT}us redeem: ${REDEEM}us"
+  DEPOSITS+="$DEPOSIT"$'\n'
+  REDEEMS+="$REDEEM"$'\n'
+done
+
+summary deposit "$DEPOSITS"
+summary redeem "$REDEEMS"
@@ -1,4 +1,17 @@
 #!/bin/bash
 
-eosio-cpp vaults.sx.cpp -I include
+# usage: ./scripts/build.sh [size]
+# `size` produces a size-optimised vaults.sx.wasm (does not match the mainnet checksum)
+if [ "$1" == "size" ]; then
+  eosio-cpp vaults.sx.cpp -I include -O=s
+  # --mvp-features keeps opcodes (ex: sign-ext) EOSIO wasm validation rejects out of the output
+  wasm-opt -Oz --mvp-features --strip-debug --strip-producers vaults.sx.wasm -o vaults.sx.wasm
+else
+  eosio-cpp vaults.sx.cpp -I include
+fi
+
+# module size & checksum
+echo "vaults.sx.wasm: $(wc -c < vaults.sx.wasm) bytes"
+shasum -a 256 vaults.sx.wasm
+
 cleos set contract vaults.sx . vaults.sx.wasm vaults.sx.abi
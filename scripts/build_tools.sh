@@ -0,0 +1,7 @@
+#!/bin/bash
+
+# native (host compiled) tooling linking `vaults.sx.math.hpp`
+mkdir -p tools/bin
+g++ -std=c++17 -O2 -Wall -Wextra -Wpedantic -I. tools/replay.cpp -o tools/bin/replay || exit 1
+g++ -std=c++17 -O2 -Wall -Wextra -Wpedantic -pthread -I. tools/fuzz.cpp -o tools/bin/fuzz || exit 1
+g++ -std=c++17 -O2 -Wall -Wextra -Wpedantic -pthread -I. tools/mirror_bench.cpp -o tools/bin/mirror_bench || exit 1
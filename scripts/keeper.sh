@@ -0,0 +1,78 @@
+#!/bin/bash
+
+# usage: ./scripts/keeper.sh [threshold] [interval] [batch]
+# pushes `update` only for vaults whose estimated price drift exceeds threshold
+THRESHOLD=${1:-0.0001}  # relative deposit drift (0.0001 = 0.01%)
+INTERVAL=${2:-60}       # seconds between scans
+BATCH=${3:-10}          # maximum `update` actions per transaction
+
+# "2000.0000 EOS" => 20000000
+amount() {
+  echo "$1" | awk '{ split($1, a, "."); printf "%d", a[1] a[2] }'
+}
+
+# staked EOS balances (voters/rexfund/refunds), mirrors `get_eos_*` helpers
+eos_staked() {
+  local staked=$(cleos get table eosio eosio voters -L $1 -U $1 | jq -r '.rows[0].staked // 0')
+  local rex_fund=$(cleos get table eosio eosio rexfund -L $1 -U $1 | jq -r '.rows[0].balance // "0.0000 EOS"')
+  local refunds=$(cleos get table eosio $1 refunds | jq -r '.rows[0] // {} | [.net_amount // "0.0000 EOS", .cpu_amount // "0.0000 EOS"] | .[]')
+  local total=$(( staked + $(amount "$rex_fund") ))
+  while read -r refund; do
+    total=$(( total + $(amount "$refund") ))
+  done <<< "$refunds"
+  echo $total
+}
+
+# all `vault` rows (paginated)
+vault_rows() {
+  local lower="" page
+  while true; do
+    page=$(cleos get table vaults.sx vaults.sx vault -l 100 ${lower:+-L $lower})
+    echo "$page" | jq -c '.rows[]'
+    [ "$(echo "$page" | jq -r '.more')" == "true" ] || break
+    lower=$(echo "$page" | jq -r '.next_key // empty')
+    [ -n "$lower" ] || break
+  done
+}
+
+while true; do
+  NOW=$(date -u +%s)
+  QUEUE=""
+
+  # estimate drift of each vault since `last_updated`
+  while read -r row; do
+    ID=$(echo "$row" | jq -r '.deposit.quantity | split(" ")[1]')
+    CONTRACT=$(echo "$row" | jq -r '.deposit.contract')
+    ACCOUNT=$(echo "$row" | jq -r '.account')
+    DEPOSIT=$(amount "$(echo "$row" | jq -r '.deposit.quantity')")
+    BUFFER=$(amount "$(echo "$row" | jq -r '.buffer.quantity')")
+    LAST_UPDATED=$(date -u -d "$(echo "$row" | jq -r '.last_updated')Z" +%s)
+
+    BALANCE=$(amount "$(cleos get currency balance $CONTRACT $ACCOUNT $ID)")
+    STAKED=0
+    if [ "$ID" == "EOS" ]; then STAKED=$(eos_staked $ACCOUNT); fi
+    if [ "$ACCOUNT" == "vaults.sx" ]; then BUFFER=0; fi
+
+    # relative drift, absolute drift (units) when recorded deposit is zero
+    DRIFT=$(awk -v d=$DEPOSIT -v e=$(( BALANCE + STAKED + BUFFER )) 'BEGIN { x = d ? (e - d) / d : e - d; printf "%.8f", x < 0 ? -x : x }')
+    if awk -v x=$DRIFT -v t=$THRESHOLD 'BEGIN { exit !(x > t) }'; then
+      QUEUE+="$DRIFT $ID $(( NOW - LAST_UPDATED ))"$'\n'
+    fi
+  done < <(vault_rows)
+
+  # priority queue ordered by drift
+  QUEUE=$(echo -n "$QUEUE" | sort -rg)
+  DEPTH=$(echo -n "$QUEUE" | grep -c .)
+  LAG=$(echo -n "$QUEUE" | awk 'BEGIN { m = 0 } $3 > m { m = $3 } END { print m }')
+  echo "$(date -u +%FT%T) queue_depth=$DEPTH max_lag=${LAG}s"
+
+  # push `update` in batches
+  echo -n "$QUEUE" | awk '{ print $2 }' | xargs -r -n $BATCH | while read -r ids; do
+    ACTIONS=$(for id in $ids; do
+      echo "{\"account\":\"vaults.sx\",\"name\":\"update\",\"authorization\":[{\"actor\":\"vaults.sx\",\"permission\":\"active\"}],\"data\":{\"id\":\"$id\"}}"
+    done | jq -sc '.')
+    cleos push transaction "{\"actions\":$ACTIONS}" > /dev/null && echo "update $ids"
+  done
+
+  sleep $INTERVAL
+done
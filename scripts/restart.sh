@@ -1,6 +1,26 @@
 #!/bin/bash
 
+# usage: ./scripts/restart.sh [snapshot]
 ./scripts/kill_nodeos.sh
+
+# boot from generated snapshot (`./scripts/snapshot.sh`) with contracts, vault & test accounts
+if [ "$1" == "snapshot" ]; then
+  SNAPSHOT=./nodeos/snapshots/vaults.sx.bin
+  [ -f $SNAPSHOT ] || { echo "run ./scripts/snapshot.sh first"; exit 1; }
+  ./scripts/start_nodeos.sh $SNAPSHOT
+
+  # wait for nodeos to accept requests
+  for i in $(seq 1 20); do
+    cleos get info > /dev/null 2>&1 && break
+    sleep 0.5
+  done
+  cleos get info > /dev/null 2>&1 || { echo "nodeos failed to start from snapshot"; tail stderr; exit 1; }
+
+  # unlock wallet
+  cleos wallet unlock --password $(cat ~/eosio-wallet/.pass)
+  exit
+fi
+
 ./scripts/start_nodeos.sh
 
 sleep 2
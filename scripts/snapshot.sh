@@ -0,0 +1,48 @@
+#!/bin/bash
+
+# usage: ./scripts/snapshot.sh [accounts]
+# generates ./nodeos/snapshots/vaults.sx.bin, start from it with `./scripts/restart.sh snapshot`
+ACCOUNTS=${1:-1000}
+KEY=EOS6MRyAjQq8ud7hVNYcfnVPJqcVpscN5So8BhtHuGYqET5GDW5CV
+ALPHABET=abcdefghijklmnopqrstuvwxyz
+
+# test.aaa ... test.zzz
+[ $ACCOUNTS -le 17576 ] || { echo "maximum 17576 accounts"; exit 1; }
+
+# test account name by index (ex: 0 => test.aaa)
+account() {
+  local n=$1 s=""
+  for k in 1 2 3; do
+    s=${ALPHABET:$(( n % 26 )):1}$s
+    n=$(( n / 26 ))
+  done
+  echo "test.$s"
+}
+
+# fresh chain with contracts & accounts
+./scripts/restart.sh
+
+# create vault
+cleos push action eosio.token open '["flash.sx", "4,EOS", "flash.sx"]' -p flash.sx
+cleos push action vaults.sx setvault '[["4,EOS", "eosio.token"], "SXEOS", "flash.sx"]' -p vaults.sx
+cleos push action vaults.sx setbuffer '["EOS", "100.0000 EOS"]' -p vaults.sx
+
+# issue EOS to fund test accounts (1000 EOS each, `deploy.sh` leaves 4,950,000 EOS with eosio)
+cleos push action eosio.token issue "[\"eosio\", \"$(( ACCOUNTS * 1000 )).0000 EOS\", \"snapshot\"]" -p eosio || exit 1
+
+# create & fund test accounts (batched 50 accounts per transaction)
+for (( i = 0; i < ACCOUNTS; i += 50 )); do
+  ACTIONS=$(for (( j = i; j < i + 50 && j < ACCOUNTS; j++ )); do
+    NAME=$(account $j)
+    cleos create account eosio $NAME $KEY -s -d -j | jq -c '.actions[]'
+    echo "{\"account\":\"eosio.token\",\"name\":\"transfer\",\"authorization\":[{\"actor\":\"eosio\",\"permission\":\"active\"}],\"data\":{\"from\":\"eosio\",\"to\":\"$NAME\",\"quantity\":\"1000.0000 EOS\",\"memo\":\"init\"}}"
+  done | jq -sc '.')
+  cleos push transaction "{\"actions\":$ACTIONS}" > /dev/null || exit 1
+done
+
+# snapshot
+sleep 2
+SNAPSHOT=$(curl -s -X POST http://127.0.0.1:8888/v1/producer/create_snapshot | jq -r '.snapshot_name')
+mkdir -p ./nodeos/snapshots
+cp $SNAPSHOT ./nodeos/snapshots/vaults.sx.bin
+echo "snapshot: ./nodeos/snapshots/vaults.sx.bin ($ACCOUNTS accounts)"
@@ -1,5 +1,13 @@
 #!/bin/bash
 
+# usage: ./scripts/start_nodeos.sh [snapshot]
+if [ -n "$1" ]; then
+  rm -rf ./nodeos/data/state ./nodeos/data/blocks ./nodeos/data/state-history
+  START="--snapshot $1"
+else
+  START="--replay-blockchain --hard-replay-blockchain --delete-all-blocks"
+fi
+
 nodeos -p eosio -e \
   --data-dir ./nodeos/data \
   --config-dir ./nodeos/config  \
@@ -15,11 +23,9 @@ nodeos -p eosio -e \
   --access-control-allow-origin=* \
   --http-validate-host=false \
   --max-transaction-time=1000 \
-  --replay-blockchain \
-  --hard-replay-blockchain \
   --verbose-http-errors \
   --disable-replay-opts \
-  --delete-all-blocks \
+  $START \
   --producer-name eosio \
   --contracts-console \
   --filter-on=* \
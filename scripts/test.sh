@@ -3,6 +3,7 @@
 # create vault
 cleos push action eosio.token open '["flash.sx", "4,EOS", "flash.sx"]' -p flash.sx
 cleos push action vaults.sx setvault '[["4,EOS", "eosio.token"], "SXEOS", "flash.sx"]' -p vaults.sx
+cleos push action vaults.sx setbuffer '["EOS", "100.0000 EOS"]' -p vaults.sx
 
 # deposit
 cleos -v transfer account.sx vaults.sx "2.0000 EOS"
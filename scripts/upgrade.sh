@@ -0,0 +1,28 @@
+#!/bin/bash
+
+# usage: ./scripts/upgrade.sh <previous commit/tag>
+# upgrade test from `vault` table layout without buffer, run after `./scripts/restart.sh`
+[ -n "$1" ] || { echo "usage: ./scripts/upgrade.sh <previous commit/tag> (ex: $(git rev-list --max-parents=0 HEAD | cut -c1-7))"; exit 1; }
+
+# deploy previous release
+PREVIOUS_DIR=$(mktemp -d)
+git archive $1 | tar -x -C $PREVIOUS_DIR || exit 1
+eosio-cpp $PREVIOUS_DIR/vaults.sx.cpp -I $PREVIOUS_DIR/include -o $PREVIOUS_DIR/vaults.sx.wasm || exit 1
+cleos set contract vaults.sx $PREVIOUS_DIR vaults.sx.wasm vaults.sx.abi
+
+# create vault & deposit (previous release)
+cleos push action eosio.token open '["flash.sx", "4,EOS", "flash.sx"]' -p flash.sx
+cleos push action vaults.sx setvault '[["4,EOS", "eosio.token"], "SXEOS", "flash.sx"]' -p vaults.sx
+cleos -v transfer account.sx vaults.sx "2.0000 EOS"
+
+# upgrade - existing vault row is read without buffer
+cleos set contract vaults.sx . vaults.sx.wasm vaults.sx.abi
+cleos -v push action vaults.sx update '["EOS"]' -p vaults.sx
+cleos -v transfer account.sx vaults.sx "1.0000 EOS"
+cleos -v transfer account.sx vaults.sx "10000.0000 SXEOS" --contract token.sx
+
+# buffer written after upgrade
+cleos push action vaults.sx setbuffer '["EOS", "100.0000 EOS"]' -p vaults.sx
+cleos -v transfer account.sx vaults.sx "2.0000 EOS"
+cleos -v transfer account.sx vaults.sx "10000.0000 SXEOS" --contract token.sx
+cleos get table vaults.sx vaults.sx vault
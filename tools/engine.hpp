@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "../vaults.sx.math.hpp"
+
+/**
+ * Host compiled vault state engine
+ *
+ * Mirrors the `vault` table bookkeeping of `sx::vaults` (`on_transfer`, `update`, `setbuffer`) on plain integers,
+ * using the same `sx::math` pricing & buffer functions as the contract.
+ */
+namespace sx::engine {
+
+struct vault {
+    uint64_t    id;             // deposit symbol code (raw)
+    uint64_t    supply_id;      // supply symbol code (raw)
+    uint64_t    account;        // vault account (name raw)
+    int64_t     deposit;
+    int64_t     staked;
+    int64_t     supply;
+    int64_t     buffer;
+    int64_t     max_buffer;
+    uint32_t    last_updated;   // block number
+};
+
+// result of a transfer into the vaults contract
+struct outcome {
+    sx::math::error err;
+    int64_t         out;        // issued supply or redeemed deposit
+    int64_t         sweep;      // transferred to vault account
+    int64_t         retrieve;   // retrieved from vault account
+};
+
+class state {
+public:
+    explicit state( const uint64_t self ) : _self( self ) {}
+
+    vault* find( const uint64_t id )
+    {
+        for ( auto& v : _vaults ) if ( v.id == id ) return &v;
+        return nullptr;
+    }
+
+    vault* find_by_supply( const uint64_t supply_id )
+    {
+        for ( auto& v : _vaults ) if ( v.supply_id == supply_id ) return &v;
+        return nullptr;
+    }
+
+    vault& insert( const vault& row )
+    {
+        if ( auto* v = find( row.id ) ) return *v = row;
+        _vaults.push_back( row );
+        return _vaults.back();
+    }
+
+    const std::vector<vault>& vaults() const { return _vaults; }
+
+    /**
+     * Incoming transfer of `amount` of symbol code `sym` to contract (deposit, redeem or burn)
+     *
+     * @return `ignored` is true when the contract would ignore the transfer
+     */
+    outcome on_transfer( const uint64_t from, const uint64_t sym, const int64_t amount, const bool burn, const uint32_t block, bool& ignored )
+    {
+        vault* deposit = find( sym );
+        vault* supply = find_by_supply( sym );
+
+        // ignore incoming transfer from vault account
+        ignored = ( deposit && from == deposit->account ) || ( supply && from == supply->account ) || ( !deposit && !supply );
+        if ( ignored ) return { sx::math::error::none, 0, 0, 0 };
+
+        if ( deposit ) return on_deposit( *deposit, amount, block );
+        if ( burn ) {
+            supply->supply -= amount;
+            supply->last_updated = block;
+            return { sx::math::error::none, 0, 0, 0 };
+        }
+        return on_redeem( *supply, amount, block );
+    }
+
+    outcome on_deposit( vault& v, const int64_t amount, const uint32_t block )
+    {
+        const auto out = sx::math::quote_issue( amount, v.deposit, v.supply );
+        if ( out.err != sx::math::error::none ) return { out.err, 0, 0, 0 };
+
+        int64_t sweep = 0;
+        if ( v.account != _self ) sweep = sx::math::sweep( v.buffer, v.max_buffer, amount );
+
+        v.deposit += amount;
+        v.supply += out.amount;
+        v.last_updated = block;
+        return { sx::math::error::none, out.amount, sweep, 0 };
+    }
+
+    outcome on_redeem( vault& v, const int64_t amount, const uint32_t block )
+    {
+        const auto out = sx::math::quote_retire( amount, v.deposit, v.supply );
+        if ( out.err != sx::math::error::none ) return { out.err, 0, 0, 0 };
+
+        // deposit (liquid balance) must be equal or above staked amount
+        if ( v.deposit - out.amount < v.staked ) return { sx::math::error::max_withdraw, 0, 0, 0 };
+
+        int64_t retrieve = 0;
+        if ( v.account != _self ) retrieve = sx::math::retrieve( v.buffer, out.amount );
+
+        v.deposit -= out.amount;
+        v.supply -= amount;
+        v.last_updated = block;
+        return { sx::math::error::none, out.amount, 0, retrieve };
+    }
+
+    // `update` from vault account balance & staked amount
+    void update( vault& v, const int64_t balance, const int64_t staked, const uint32_t block )
+    {
+        const int64_t buffer = v.account != _self ? v.buffer : 0;
+        v.deposit = balance + staked + buffer;
+        v.staked = staked;
+        v.last_updated = block;
+    }
+
+    void setbuffer( vault& v, const int64_t max_buffer )
+    {
+        v.max_buffer = max_buffer;
+    }
+
+private:
+    uint64_t _self;
+    std::vector<vault> _vaults;
+};
+
+} // namespace sx::engine
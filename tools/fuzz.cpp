@@ -0,0 +1,223 @@
+/**
+ * Differential fuzzer for issue/retire rounding drift
+ *
+ * ```bash
+ * $ ./tools/bin/fuzz [sequences] [operations] [threads] [seed]
+ * ```
+ *
+ * Runs randomized deposit & redeem sequences through the contract pricing (`sx::math::quote_issue` & `quote_retire`,
+ * including the contract guards) and compares the vault price `deposit / supply` against the exact reference price,
+ * which issue & redeem leave unchanged without truncation. Price comparison is exact (128-bit cross multiplication),
+ * floating point is only used to print the results.
+ *
+ * - price drift - `(deposit * R_ref) / (supply * S_ref) - 1` against the price set by the initial deposit (exact)
+ * - operation leak - exact value of a deposit/redeem minus what the user received at the pre-operation price,
+ *   each term is exact (128-bit), the per-sequence sum is accumulated in long double (deposit units)
+ *
+ * Truncation must only round in favour of the vault, any negative drift is reported as a violation.
+ * `update` is not simulated, it assigns recorded balances without truncation.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "../vaults.sx.math.hpp"
+
+namespace {
+
+using sx::math::uint128_t;
+__extension__ typedef __int128 int128_t;
+
+constexpr int HOLDERS = 4;
+constexpr int BUCKETS = 10; // checkpoints at 10^1 .. 10^10 operations
+
+struct rng {
+    uint64_t s;
+    uint64_t next()
+    {
+        // splitmix64
+        uint64_t z = ( s += 0x9e3779b97f4a7c15ULL );
+        z = ( z ^ ( z >> 30 ) ) * 0xbf58476d1ce4e5b9ULL;
+        z = ( z ^ ( z >> 27 ) ) * 0x94d049bb133111ebULL;
+        return z ^ ( z >> 31 );
+    }
+    // uniform in [1, max]
+    int64_t range( const int64_t max ) { return max <= 1 ? 1 : 1 + int64_t( next() % uint64_t( max ) ); }
+    // log-uniform in [1, max]
+    int64_t log_range( const int64_t max )
+    {
+        int bits = 1;
+        while ( bits < 62 && ( int64_t( 1 ) << bits ) <= max ) ++bits;
+        return range( std::min( max, ( int64_t( 1 ) << range( bits ) ) - 1 ) );
+    }
+};
+
+struct bucket {
+    uint64_t    sequences = 0;
+    long double max_drift = 0;      // price drift
+    long double max_leak = 0;       // cumulative operation leak (deposit units)
+    long double max_supply = 0;     // fraction of asset_max
+};
+
+struct stats {
+    bucket      buckets[BUCKETS];
+    uint64_t    operations = 0;
+    uint64_t    rejected[8] = {};
+    uint64_t    stranded = 0;       // supply retired to zero with deposit left in vault
+    int64_t     max_stranded = 0;
+    uint64_t    violations = 0;
+    long double max_op_leak = 0;    // worst single operation leak (deposit units)
+};
+
+struct vault {
+    int64_t deposit = 0;
+    int64_t supply = 0;
+    int64_t ref_deposit = 0;        // reference price `ref_deposit / ref_supply`
+    int64_t ref_supply = 0;
+    int64_t holders[HOLDERS] = {};
+    long double leak = 0;
+};
+
+void record( const vault& v, bucket& b, stats& st )
+{
+    if ( !v.supply || !v.ref_supply ) return;
+
+    // deposit / supply vs. ref_deposit / ref_supply (exact)
+    const int128_t lhs = int128_t( v.deposit ) * v.ref_supply;
+    const int128_t rhs = int128_t( v.ref_deposit ) * v.supply;
+    if ( lhs < rhs ) ++st.violations;
+
+    b.max_drift = std::max( b.max_drift, (long double) ( lhs - rhs ) / (long double) rhs );
+    b.max_leak = std::max( b.max_leak, v.leak );
+    b.max_supply = std::max( b.max_supply, (long double) v.supply / sx::math::asset_max );
+}
+
+// exact leak `numerator / denominator` (deposit units), must not be negative
+void leak( vault& v, const int128_t numerator, const int64_t denominator, stats& st )
+{
+    if ( numerator < 0 ) ++st.violations;
+    const long double value = (long double) numerator / denominator;
+    v.leak += value;
+    st.max_op_leak = std::max( st.max_op_leak, value );
+}
+
+void step( rng& r, vault& v, stats& st )
+{
+    const int h = int( r.next() % HOLDERS );
+    const bool dust = r.next() % 10 == 0;
+    const bool deposit = v.holders[h] == 0 || r.next() % 2;
+
+    if ( deposit ) {
+        // token amounts are bounded by asset_max
+        const int64_t room = sx::math::asset_max - v.deposit;
+        if ( room <= 0 ) return;
+        const int64_t payment = dust ? r.range( std::min<int64_t>( 100, room ) ) : r.log_range( std::min<int64_t>( room, int64_t( 1 ) << 50 ) );
+        const auto out = sx::math::quote_issue( payment, v.deposit, v.supply );
+        if ( out.err != sx::math::error::none ) { ++st.rejected[ int( out.err ) ]; return; }
+
+        // paid `payment`, received `out` supply worth `out * S0 / R0`
+        if ( v.supply ) leak( v, int128_t( payment ) * v.supply - int128_t( out.amount ) * v.deposit, v.supply, st );
+
+        const bool initial = v.supply == 0;
+        v.deposit += payment;
+        v.supply += out.amount;
+        v.holders[h] += out.amount;
+
+        // initial issuance sets the reference price
+        if ( initial ) {
+            v.ref_deposit = v.deposit;
+            v.ref_supply = v.supply;
+        }
+    } else {
+        const int64_t payment = dust ? r.range( std::min<int64_t>( 100, v.holders[h] ) )
+            : r.next() % 4 == 0 ? v.holders[h] : r.range( v.holders[h] );
+        const auto out = sx::math::quote_retire( payment, v.deposit, v.supply );
+        if ( out.err != sx::math::error::none ) { ++st.rejected[ int( out.err ) ]; return; }
+
+        // retired `payment` supply worth `payment * S0 / R0`, received `out`
+        leak( v, int128_t( payment ) * v.deposit - int128_t( out.amount ) * v.supply, v.supply, st );
+
+        v.deposit -= out.amount;
+        v.supply -= payment;
+        v.holders[h] -= payment;
+
+        // deposit left behind is gifted to the next initial depositor
+        if ( v.supply == 0 && v.deposit > 0 ) {
+            ++st.stranded;
+            st.max_stranded = std::max( st.max_stranded, v.deposit );
+        }
+    }
+    ++st.operations;
+}
+
+void run_sequence( rng& r, const uint64_t operations, stats& st )
+{
+    vault v;
+    uint64_t checkpoint = 10;
+    for ( uint64_t op = 1, i = 0; op <= operations; ++op ) {
+        step( r, v, st );
+        if ( op == checkpoint && i < BUCKETS ) {
+            auto& b = st.buckets[i++];
+            ++b.sequences;
+            record( v, b, st );
+            checkpoint *= 10;
+        }
+    }
+}
+
+} // namespace
+
+int main( int argc, char** argv )
+{
+    const uint64_t sequences = argc > 1 ? std::strtoull( argv[1], nullptr, 10 ) : 100000;
+    const uint64_t operations = argc > 2 ? std::strtoull( argv[2], nullptr, 10 ) : 10000;
+    const unsigned threads = argc > 3 ? unsigned( std::strtoul( argv[3], nullptr, 10 ) ) : std::max( 1u, std::thread::hardware_concurrency() );
+    const uint64_t seed = argc > 4 ? std::strtoull( argv[4], nullptr, 10 ) : 1;
+
+    std::vector<stats> results( threads );
+    std::vector<std::thread> workers;
+    const auto start = std::chrono::steady_clock::now();
+    for ( unsigned t = 0; t < threads; ++t ) {
+        workers.emplace_back( [&, t]() {
+            rng r{ seed * 0x100000001b3ULL + t };
+            for ( uint64_t i = t; i < sequences; i += threads ) run_sequence( r, operations, results[t] );
+        });
+    }
+    for ( auto& w : workers ) w.join();
+    const double seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+
+    stats total;
+    for ( const auto& st : results ) {
+        total.operations += st.operations;
+        total.stranded += st.stranded;
+        total.violations += st.violations;
+        total.max_stranded = std::max( total.max_stranded, st.max_stranded );
+        total.max_op_leak = std::max( total.max_op_leak, st.max_op_leak );
+        for ( int i = 0; i < 8; ++i ) total.rejected[i] += st.rejected[i];
+        for ( int i = 0; i < BUCKETS; ++i ) {
+            auto& b = total.buckets[i];
+            b.sequences += st.buckets[i].sequences;
+            b.max_drift = std::max( b.max_drift, st.buckets[i].max_drift );
+            b.max_leak = std::max( b.max_leak, st.buckets[i].max_leak );
+            b.max_supply = std::max( b.max_supply, st.buckets[i].max_supply );
+        }
+    }
+
+    std::printf( "%llu sequences x %llu operations, %u threads, seed %llu\n", (unsigned long long) sequences, (unsigned long long) operations, threads, (unsigned long long) seed );
+    std::printf( "%llu accepted operations in %.2fs (%.1fM ops/s)\n\n", (unsigned long long) total.operations, seconds, total.operations / seconds / 1e6 );
+    std::printf( "%12s %12s %16s %16s %14s\n", "operations", "sequences", "max price drift", "max leak", "max supply" );
+    uint64_t checkpoint = 10;
+    for ( int i = 0; i < BUCKETS && total.buckets[i].sequences; ++i, checkpoint *= 10 ) {
+        const auto& b = total.buckets[i];
+        std::printf( "%12llu %12llu %16.6Le %16.4Lf %14.6Le\n", (unsigned long long) checkpoint, (unsigned long long) b.sequences, b.max_drift, b.max_leak, b.max_supply );
+    }
+    std::printf( "\nrejected:" );
+    for ( int i = 1; i < 8; ++i ) if ( total.rejected[i] ) std::printf( " %s=%llu", sx::math::message( sx::math::error( i ) ), (unsigned long long) total.rejected[i] );
+    std::printf( "\nstranded deposit on zero supply: %llu (max %lld units)\n", (unsigned long long) total.stranded, (long long) total.max_stranded );
+    std::printf( "worst single operation leak: %.6Lf units\n", total.max_op_leak );
+    std::printf( "violations (rounding against vault): %llu\n", (unsigned long long) total.violations );
+    return total.violations ? 2 : 0;
+}
@@ -0,0 +1,205 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <type_traits>
+
+#include "../vaults.sx.math.hpp"
+
+/**
+ * In-process vault state mirror
+ *
+ * A single writer applies decoded state-history deltas (`vault` table rows of the vaults contract & token balance
+ * rows of vault accounts), any number of reader threads get consistent per-vault snapshots without blocking the
+ * writer (seqlock). Quotes use `sx::math`, matching `get_issue_quote` / `get_retire_quote` of the contract.
+ *
+ * Decoding of state-history `contract_row` deltas (ABI deserialization) is done by the caller's SHiP client.
+ */
+namespace sx::mirror {
+
+/**
+ * Single writer / multi reader sequence lock
+ *
+ * Value is stored as relaxed atomic words so concurrent reads are free of data races, readers retry on torn reads.
+ */
+template <typename T>
+class seqlock {
+    static_assert( std::is_trivially_copyable<T>::value, "seqlock value must be trivially copyable" );
+    static constexpr size_t WORDS = ( sizeof( T ) + sizeof( uint64_t ) - 1 ) / sizeof( uint64_t );
+
+public:
+    seqlock() { store( T{} ); }
+
+    // writer only
+    void store( const T& value )
+    {
+        uint64_t words[WORDS] = {};
+        std::memcpy( words, &value, sizeof( T ) );
+
+        const uint64_t seq = _seq.load( std::memory_order_relaxed );
+        _seq.store( seq + 1, std::memory_order_relaxed );
+        std::atomic_thread_fence( std::memory_order_release );
+        for ( size_t i = 0; i < WORDS; ++i ) _data[i].store( words[i], std::memory_order_relaxed );
+        _seq.store( seq + 2, std::memory_order_release );
+    }
+
+    T load() const
+    {
+        uint64_t words[WORDS];
+        for ( ;; ) {
+            const uint64_t seq = _seq.load( std::memory_order_acquire );
+            if ( seq & 1 ) continue;
+            for ( size_t i = 0; i < WORDS; ++i ) words[i] = _data[i].load( std::memory_order_relaxed );
+            std::atomic_thread_fence( std::memory_order_acquire );
+            if ( _seq.load( std::memory_order_relaxed ) == seq ) break;
+        }
+        T value;
+        std::memcpy( &value, words, sizeof( T ) );
+        return value;
+    }
+
+    uint64_t version() const { return _seq.load( std::memory_order_acquire ) / 2; }
+
+private:
+    std::atomic<uint64_t> _seq{ 0 };
+    std::atomic<uint64_t> _data[WORDS];
+};
+
+// decoded `vault` row delta
+struct vault_row {
+    uint64_t    id;             // deposit symbol code (raw)
+    uint64_t    supply_id;      // supply symbol code (raw)
+    uint64_t    contract;       // deposit token contract (name raw)
+    uint64_t    account;        // vault account (name raw)
+    int64_t     deposit;
+    int64_t     staked;
+    int64_t     supply;
+    int64_t     buffer;         // 0 for rows without buffer extension
+    int64_t     max_buffer;
+    uint32_t    last_updated;   // time_point_sec
+};
+
+struct vault_snapshot {
+    vault_row   row;
+    int64_t     balance;        // vault account liquid balance of deposit token
+    uint32_t    block;          // block of last applied delta
+    bool        present;        // false once row is removed
+};
+
+template <size_t CAPACITY = 64>
+class vault_mirror {
+public:
+    explicit vault_mirror( const uint64_t self ) : _self( self ) {}
+
+    // writer - `vault` table delta (present = false for removed rows)
+    void apply_vault_delta( const vault_row& row, const bool present, const uint32_t block )
+    {
+        slot* s = find_or_insert( row.id );
+        if ( !s ) return;
+        vault_snapshot snapshot = s->value.load();
+        snapshot.row = row;
+        snapshot.block = block;
+        snapshot.present = present;
+        s->supply_id.store( row.supply_id, std::memory_order_release );
+        s->value.store( snapshot );
+    }
+
+    // writer - token `accounts` table delta of `owner` balance
+    void apply_balance_delta( const uint64_t contract, const uint64_t owner, const uint64_t sym, const int64_t balance, const uint32_t block )
+    {
+        slot* s = find( sym );
+        if ( !s ) return;
+        vault_snapshot snapshot = s->value.load();
+        if ( !snapshot.present || snapshot.row.contract != contract || snapshot.row.account != owner ) return;
+        snapshot.balance = balance;
+        snapshot.block = block;
+        s->value.store( snapshot );
+    }
+
+    // reader - consistent snapshot by deposit symbol code
+    std::optional<vault_snapshot> get( const uint64_t id ) const
+    {
+        const slot* s = find( id );
+        if ( !s ) return std::nullopt;
+        const vault_snapshot snapshot = s->value.load();
+        if ( !snapshot.present ) return std::nullopt;
+        return snapshot;
+    }
+
+    // reader - consistent snapshot by supply symbol code
+    std::optional<vault_snapshot> get_by_supply( const uint64_t supply_id ) const
+    {
+        for ( const auto& s : _slots ) {
+            if ( !s.id.load( std::memory_order_acquire ) ) break;
+            if ( s.supply_id.load( std::memory_order_acquire ) != supply_id ) continue;
+            const vault_snapshot snapshot = s.value.load();
+            if ( snapshot.present && snapshot.row.supply_id == supply_id ) return snapshot;
+        }
+        return std::nullopt;
+    }
+
+    // reader - supply issued for depositing `amount` (same as `get_issue_quote`)
+    sx::math::quote quote_issue( const uint64_t id, const int64_t amount ) const
+    {
+        const auto snapshot = get( id );
+        if ( !snapshot ) return { 0, sx::math::error::no_deposit };
+        return sx::math::quote_issue( amount, snapshot->row.deposit, snapshot->row.supply );
+    }
+
+    // reader - deposit redeemed for retiring `amount` supply (same as `get_retire_quote`)
+    sx::math::quote quote_retire( const uint64_t supply_id, const int64_t amount ) const
+    {
+        const auto snapshot = get_by_supply( supply_id );
+        if ( !snapshot ) return { 0, sx::math::error::no_supply };
+        return sx::math::quote_retire( amount, snapshot->row.deposit, snapshot->row.supply );
+    }
+
+    // reader - deposit including balance changes since `last_updated` (what `update` would record)
+    static int64_t estimated_deposit( const vault_snapshot& snapshot, const uint64_t self )
+    {
+        const int64_t buffer = snapshot.row.account != self ? snapshot.row.buffer : 0;
+        return snapshot.balance + snapshot.row.staked + buffer;
+    }
+
+    uint64_t self() const { return _self; }
+
+private:
+    struct slot {
+        std::atomic<uint64_t> id{ 0 };
+        std::atomic<uint64_t> supply_id{ 0 };
+        seqlock<vault_snapshot> value;
+    };
+
+    const slot* find( const uint64_t id ) const
+    {
+        for ( const auto& s : _slots ) {
+            const uint64_t key = s.id.load( std::memory_order_acquire );
+            if ( !key ) return nullptr;
+            if ( key == id ) return &s;
+        }
+        return nullptr;
+    }
+
+    slot* find( const uint64_t id ) { return const_cast<slot*>( static_cast<const vault_mirror*>( this )->find( id ) ); }
+
+    // slots are insert-only, readers never observe a slot being reused
+    slot* find_or_insert( const uint64_t id )
+    {
+        for ( auto& s : _slots ) {
+            const uint64_t key = s.id.load( std::memory_order_relaxed );
+            if ( key == id ) return &s;
+            if ( !key ) {
+                s.id.store( id, std::memory_order_release );
+                return &s;
+            }
+        }
+        return nullptr;
+    }
+
+    uint64_t _self;
+    slot _slots[CAPACITY];
+};
+
+} // namespace sx::mirror
@@ -0,0 +1,97 @@
+/**
+ * Vault mirror consistency & read latency benchmark
+ *
+ * ```bash
+ * $ ./tools/bin/mirror_bench [readers] [seconds]
+ * ```
+ *
+ * One writer applies `vault` and balance deltas as fast as possible while reader threads take snapshots & quotes.
+ * Every written row satisfies `supply == deposit * ratio`, `staked == deposit / 2` & `balance == deposit - staked`,
+ * a snapshot violating them is a torn read.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "mirror.hpp"
+
+namespace {
+
+constexpr uint64_t SELF = 0xc2a36c5c00000000ULL; // vaults.sx
+constexpr uint64_t ACCOUNT = 0x5d2e4b4c00000000ULL; // flash.sx
+constexpr uint64_t CONTRACT = 0x5530ea033482a600ULL; // eosio.token
+constexpr int VAULTS = 8;
+
+uint64_t vault_id( const int i ) { return 0x534f45ULL + ( uint64_t( i ) << 24 ); } // EOS, EOS\x01, ...
+uint64_t supply_id( const int i ) { return ( vault_id( i ) << 16 ) | 0x5853ULL; } // SX + id
+
+} // namespace
+
+int main( int argc, char** argv )
+{
+    const unsigned readers = argc > 1 ? unsigned( std::strtoul( argv[1], nullptr, 10 ) ) : 2;
+    const double seconds = argc > 2 ? std::strtod( argv[2], nullptr ) : 2;
+
+    sx::mirror::vault_mirror<> mirror( SELF );
+    std::atomic<bool> done{ false };
+    std::atomic<uint64_t> writes{ 0 };
+
+    // writer
+    std::thread writer( [&]() {
+        uint64_t n = 0;
+        uint32_t block = 1;
+        while ( !done.load( std::memory_order_relaxed ) ) {
+            const int i = int( n % VAULTS );
+            const int64_t deposit = 10000 + int64_t( n % 1000003 );
+            const sx::mirror::vault_row row{ vault_id( i ), supply_id( i ), CONTRACT, ACCOUNT, deposit, deposit / 2, deposit * sx::math::ratio, 0, 0, block };
+            mirror.apply_vault_delta( row, true, block );
+            mirror.apply_balance_delta( CONTRACT, ACCOUNT, vault_id( i ), deposit - deposit / 2, block );
+            if ( ++n % 64 == 0 ) ++block;
+        }
+        writes.store( n );
+    });
+
+    // readers
+    std::vector<uint64_t> reads( readers ), torn( readers ), mismatched( readers );
+    std::vector<std::thread> threads;
+    for ( unsigned t = 0; t < readers; ++t ) {
+        threads.emplace_back( [&, t]() {
+            uint64_t n = 0;
+            while ( !done.load( std::memory_order_relaxed ) ) {
+                const int i = int( n % VAULTS );
+                const auto snapshot = mirror.get( vault_id( i ) );
+                ++n;
+                if ( !snapshot ) continue;
+                const auto& row = snapshot->row;
+
+                // balance delta follows vault delta, snapshot may hold previous balance
+                if ( row.supply != row.deposit * sx::math::ratio || row.staked != row.deposit / 2 || row.supply_id != supply_id( i ) ) ++torn[t];
+
+                // quote from mirror matches contract math on the snapshot
+                const auto quote = mirror.quote_retire( supply_id( i ), sx::math::ratio );
+                if ( quote.err != sx::math::error::none || quote.amount <= 0 ) ++mismatched[t];
+            }
+            reads[t] = n;
+        });
+    }
+
+    std::this_thread::sleep_for( std::chrono::duration<double>( seconds ) );
+    done.store( true );
+    writer.join();
+    for ( auto& t : threads ) t.join();
+
+    uint64_t total_reads = 0, total_torn = 0, total_mismatched = 0;
+    for ( unsigned t = 0; t < readers; ++t ) {
+        total_reads += reads[t];
+        total_torn += torn[t];
+        total_mismatched += mismatched[t];
+    }
+    std::printf( "writer: %llu deltas (%.1fM/s)\n", (unsigned long long) writes.load(), writes.load() / seconds / 1e6 );
+    std::printf( "readers: %u, %llu snapshot+quote reads (%.1fM/s, %.0f ns/read per thread)\n", readers, (unsigned long long) total_reads,
+        total_reads / seconds / 1e6, total_reads ? seconds * 1e9 * readers / total_reads : 0 );
+    std::printf( "torn snapshots: %llu, failed quotes: %llu\n", (unsigned long long) total_torn, (unsigned long long) total_mismatched );
+    return total_torn || total_mismatched ? 2 : 0;
+}
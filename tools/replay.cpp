@@ -0,0 +1,451 @@
+/**
+ * Historical replay of vaults.sx traces through the host compiled vault engine
+ *
+ * ```bash
+ * $ ./tools/bin/replay import traces.jsonl events.bin [self]
+ * $ ./tools/bin/replay run events.bin [curves.csv] [--resync]
+ * ```
+ *
+ * `import` converts exported JSON lines (one flat object per line) into a binary event log,
+ * `run` memory-maps the event log and replays it, writing per-block curves & reporting divergence
+ * between the engine and recorded `vault` rows.
+ *
+ * ### JSON lines
+ *
+ * ```json
+ * {"block": 10, "type": "vault", "deposit": "2000.0000 EOS", "staked": "800.0000 EOS", "supply": "1000000.0000 SXEOS", "account": "flash.sx", "buffer": "0.0000 EOS", "max_buffer": "0.0000 EOS"}
+ * {"block": 11, "type": "transfer", "from": "myaccount", "to": "vaults.sx", "quantity": "1.0000 EOS", "memo": ""}
+ * {"block": 12, "type": "update", "id": "EOS", "balance": "1201.0000 EOS", "staked": "800.0000 EOS"}
+ * {"block": 13, "type": "setbuffer", "id": "EOS", "max_buffer": "100.0000 EOS"}
+ * ```
+ *
+ * - `vault` - recorded vault row (table delta), seeds unknown vaults & is compared against the engine
+ * - `transfer` - token transfer to contract (deposit, redeem or 🔥 burn), transfers to other accounts are skipped
+ * - `update` - vault account liquid `balance` & `staked` read by `update` (or recorded `deposit` after update)
+ * - `setbuffer` - vault buffer threshold
+ */
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "engine.hpp"
+
+namespace {
+
+enum class event_type : uint8_t { vault, transfer, update, setbuffer };
+
+struct event {
+    uint32_t    block;
+    event_type  type;
+    uint8_t     burn;
+    uint16_t    flags;      // update: 1 if a[0] is recorded deposit instead of balance
+    uint64_t    sym;        // deposit or transfer symbol code
+    uint64_t    name;       // transfer `from` or vault `account`
+    uint64_t    sym2;       // vault supply symbol code
+    int64_t     a[5];       // transfer: amount | update: balance, staked | vault: deposit, staked, supply, buffer, max_buffer | setbuffer: max_buffer
+};
+
+struct log_header {
+    char        magic[8];
+    uint64_t    count;
+    uint64_t    self;       // vaults contract account
+};
+
+constexpr char MAGIC[8] = { 'S', 'X', 'V', 'L', 'O', 'G', '1', '\0' };
+
+// eosio name encoding
+uint64_t to_name( const std::string& str )
+{
+    const auto char_to_value = []( const char c ) -> uint64_t {
+        if ( c == '.' ) return 0;
+        if ( c >= '1' && c <= '5' ) return ( c - '1' ) + 1;
+        if ( c >= 'a' && c <= 'z' ) return ( c - 'a' ) + 6;
+        return 0;
+    };
+    uint64_t value = 0;
+    for ( size_t i = 0; i < str.size() && i < 13; ++i ) {
+        uint64_t c = char_to_value( str[i] );
+        if ( i < 12 ) c = ( c & 0x1f ) << ( 64 - 5 * ( i + 1 ) );
+        else c &= 0x0f;
+        value |= c;
+    }
+    return value;
+}
+
+// eosio symbol code encoding
+uint64_t to_symbol_code( const std::string& str )
+{
+    uint64_t value = 0;
+    for ( size_t i = 0; i < str.size() && i < 7; ++i ) value |= uint64_t( uint8_t( str[i] ) ) << ( 8 * i );
+    return value;
+}
+
+std::string from_symbol_code( uint64_t value )
+{
+    std::string str;
+    for ( ; value; value >>= 8 ) str += char( value & 0xff );
+    return str;
+}
+
+// "1.0000 EOS" => { 10000, "EOS" }
+bool parse_asset( const std::string& str, int64_t& amount, uint64_t& sym )
+{
+    const auto space = str.find( ' ' );
+    if ( space == std::string::npos ) return false;
+    std::string digits;
+    bool negative = false;
+    for ( size_t i = 0; i < space; ++i ) {
+        if ( str[i] == '-' ) negative = true;
+        else if ( str[i] >= '0' && str[i] <= '9' ) digits += str[i];
+        else if ( str[i] != '.' ) return false;
+    }
+    if ( digits.empty() ) return false;
+    amount = std::strtoll( digits.c_str(), nullptr, 10 );
+    if ( negative ) amount = -amount;
+    sym = to_symbol_code( str.substr( space + 1 ) );
+    return true;
+}
+
+void append_utf8( std::string& out, uint32_t cp )
+{
+    if ( cp < 0x80 ) out += char( cp );
+    else if ( cp < 0x800 ) { out += char( 0xc0 | ( cp >> 6 ) ); out += char( 0x80 | ( cp & 0x3f ) ); }
+    else if ( cp < 0x10000 ) { out += char( 0xe0 | ( cp >> 12 ) ); out += char( 0x80 | ( ( cp >> 6 ) & 0x3f ) ); out += char( 0x80 | ( cp & 0x3f ) ); }
+    else { out += char( 0xf0 | ( cp >> 18 ) ); out += char( 0x80 | ( ( cp >> 12 ) & 0x3f ) ); out += char( 0x80 | ( ( cp >> 6 ) & 0x3f ) ); out += char( 0x80 | ( cp & 0x3f ) ); }
+}
+
+// flat JSON object => key/value pairs (string, number & literal values)
+bool parse_flat_json( const std::string& line, std::vector<std::pair<std::string, std::string>>& fields )
+{
+    fields.clear();
+    size_t i = 0;
+    const auto skip = [&]() { while ( i < line.size() && std::isspace( uint8_t( line[i] ) ) ) ++i; };
+    const auto parse_string = [&]( std::string& out ) -> bool {
+        if ( line[i] != '"' ) return false;
+        for ( ++i; i < line.size() && line[i] != '"'; ++i ) {
+            if ( line[i] != '\\' ) { out += line[i]; continue; }
+            if ( ++i >= line.size() ) return false;
+            switch ( line[i] ) {
+                case 'n': out += '\n'; break;
+                case 't': out += '\t'; break;
+                case 'r': out += '\r'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'u': {
+                    if ( i + 4 >= line.size() ) return false;
+                    uint32_t cp = std::strtoul( line.substr( i + 1, 4 ).c_str(), nullptr, 16 );
+                    i += 4;
+                    // surrogate pair
+                    if ( cp >= 0xd800 && cp < 0xdc00 && i + 6 < line.size() && line[i + 1] == '\\' && line[i + 2] == 'u' ) {
+                        const uint32_t low = std::strtoul( line.substr( i + 3, 4 ).c_str(), nullptr, 16 );
+                        cp = 0x10000 + ( ( cp - 0xd800 ) << 10 ) + ( low - 0xdc00 );
+                        i += 6;
+                    }
+                    append_utf8( out, cp );
+                    break;
+                }
+                default: out += line[i];
+            }
+        }
+        if ( i >= line.size() ) return false;
+        ++i;
+        return true;
+    };
+
+    skip();
+    if ( i >= line.size() || line[i] != '{' ) return false;
+    ++i;
+    for ( ;; ) {
+        skip();
+        if ( i < line.size() && line[i] == '}' ) return true;
+        std::string key, value;
+        if ( i >= line.size() || !parse_string( key ) ) return false;
+        skip();
+        if ( i >= line.size() || line[i] != ':' ) return false;
+        ++i;
+        skip();
+        if ( i >= line.size() || line[i] == '{' || line[i] == '[' ) return false;
+        if ( line[i] == '"' ) {
+            if ( !parse_string( value ) ) return false;
+        } else {
+            while ( i < line.size() && line[i] != ',' && line[i] != '}' && !std::isspace( uint8_t( line[i] ) ) ) value += line[i++];
+        }
+        fields.emplace_back( std::move( key ), std::move( value ) );
+        skip();
+        if ( i < line.size() && line[i] == ',' ) { ++i; continue; }
+        if ( i < line.size() && line[i] == '}' ) return true;
+        return false;
+    }
+}
+
+const std::string* field( const std::vector<std::pair<std::string, std::string>>& fields, const char* key )
+{
+    for ( const auto& f : fields ) if ( f.first == key ) return &f.second;
+    return nullptr;
+}
+
+int import( const char* input, const char* output, const char* self )
+{
+    std::ifstream in( input );
+    if ( !in ) { std::fprintf( stderr, "cannot open %s\n", input ); return 1; }
+    FILE* out = std::fopen( output, "wb" );
+    if ( !out ) { std::fprintf( stderr, "cannot open %s\n", output ); return 1; }
+
+    log_header header{};
+    std::memcpy( header.magic, MAGIC, sizeof( MAGIC ) );
+    header.self = to_name( self );
+    std::fwrite( &header, sizeof( header ), 1, out );
+
+    std::vector<std::pair<std::string, std::string>> fields;
+    std::string line;
+    uint64_t lines = 0, skipped = 0;
+    while ( std::getline( in, line ) ) {
+        ++lines;
+        if ( line.empty() ) continue;
+        event e{};
+        bool ok = parse_flat_json( line, fields );
+        const std::string* type = ok ? field( fields, "type" ) : nullptr;
+        const std::string* block = ok ? field( fields, "block" ) : nullptr;
+        ok = type && block;
+        if ( ok ) e.block = std::strtoul( block->c_str(), nullptr, 10 );
+
+        const auto get_asset = [&]( const char* key, int64_t& amount, uint64_t* sym ) {
+            const std::string* value = field( fields, key );
+            uint64_t s = 0;
+            if ( !value || !parse_asset( *value, amount, s ) ) return false;
+            if ( sym ) *sym = s;
+            return true;
+        };
+
+        if ( !ok ) {
+        } else if ( *type == "transfer" ) {
+            const std::string* to = field( fields, "to" );
+            const std::string* from = field( fields, "from" );
+            const std::string* memo = field( fields, "memo" );
+            e.type = event_type::transfer;
+            ok = to && from && *to == self && get_asset( "quantity", e.a[0], &e.sym );
+            if ( ok ) {
+                e.name = to_name( *from );
+                e.burn = memo && *memo == "🔥";
+            } else if ( to && *to != self ) {
+                continue; // outgoing transfers are ignored by contract
+            }
+        } else if ( *type == "vault" ) {
+            const std::string* account = field( fields, "account" );
+            e.type = event_type::vault;
+            ok = account && get_asset( "deposit", e.a[0], &e.sym ) && get_asset( "staked", e.a[1], nullptr ) && get_asset( "supply", e.a[2], &e.sym2 );
+            if ( ok ) {
+                e.name = to_name( *account );
+                get_asset( "buffer", e.a[3], nullptr );
+                get_asset( "max_buffer", e.a[4], nullptr );
+            }
+        } else if ( *type == "update" ) {
+            const std::string* id = field( fields, "id" );
+            e.type = event_type::update;
+            ok = id && get_asset( "staked", e.a[1], nullptr );
+            if ( ok ) {
+                e.sym = to_symbol_code( *id );
+                if ( !get_asset( "balance", e.a[0], nullptr ) ) {
+                    e.flags = 1;
+                    ok = get_asset( "deposit", e.a[0], nullptr );
+                }
+            }
+        } else if ( *type == "setbuffer" ) {
+            const std::string* id = field( fields, "id" );
+            e.type = event_type::setbuffer;
+            ok = id && get_asset( "max_buffer", e.a[0], nullptr );
+            if ( ok ) e.sym = to_symbol_code( *id );
+        } else {
+            ok = false;
+        }
+
+        if ( !ok ) {
+            if ( ++skipped <= 10 ) std::fprintf( stderr, "skipped line %llu: %s\n", (unsigned long long) lines, line.c_str() );
+            continue;
+        }
+        std::fwrite( &e, sizeof( e ), 1, out );
+        ++header.count;
+    }
+
+    std::fseek( out, 0, SEEK_SET );
+    std::fwrite( &header, sizeof( header ), 1, out );
+    std::fclose( out );
+    std::fprintf( stderr, "imported %llu events (%llu lines, %llu skipped)\n", (unsigned long long) header.count, (unsigned long long) lines, (unsigned long long) skipped );
+    return 0;
+}
+
+struct divergence {
+    uint64_t    compared = 0;
+    uint64_t    mismatched = 0;
+    uint64_t    rejected = 0;       // recorded transfers the engine rejects
+    int64_t     max_deposit = 0;
+    int64_t     max_supply = 0;
+    int64_t     max_buffer = 0;
+    uint32_t    first_block = 0;
+};
+
+int64_t abs_diff( const int64_t a, const int64_t b ) { return a > b ? a - b : b - a; }
+
+void write_curves( FILE* csv, const sx::engine::state& state, const std::vector<uint64_t>& touched, const uint32_t block )
+{
+    for ( const auto id : touched ) {
+        for ( const auto& v : state.vaults() ) {
+            if ( v.id != id ) continue;
+            const double price = v.supply ? double( v.deposit ) / double( v.supply ) : 0;
+            std::fprintf( csv, "%u,%s,%lld,%lld,%lld,%lld,%lld,%.12g\n", block, from_symbol_code( v.id ).c_str(),
+                (long long) v.deposit, (long long) v.staked, (long long) ( v.deposit - v.staked ), (long long) v.supply, (long long) v.buffer, price );
+        }
+    }
+}
+
+int run( const char* input, const char* output, const bool resync )
+{
+    const int fd = open( input, O_RDONLY );
+    if ( fd < 0 ) { std::fprintf( stderr, "cannot open %s\n", input ); return 1; }
+    struct stat st{};
+    fstat( fd, &st );
+    if ( size_t( st.st_size ) < sizeof( log_header ) ) { std::fprintf( stderr, "invalid event log\n" ); return 1; }
+
+    void* data = mmap( nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+    if ( data == MAP_FAILED ) { std::fprintf( stderr, "mmap failed\n" ); return 1; }
+    madvise( data, st.st_size, MADV_SEQUENTIAL );
+
+    const auto* header = static_cast<const log_header*>( data );
+    if ( std::memcmp( header->magic, MAGIC, sizeof( MAGIC ) ) || sizeof( log_header ) + header->count * sizeof( event ) > size_t( st.st_size ) ) {
+        std::fprintf( stderr, "invalid event log\n" );
+        return 1;
+    }
+    const auto* events = reinterpret_cast<const event*>( header + 1 );
+    const uint64_t self = header->self;
+
+    FILE* csv = output ? std::fopen( output, "w" ) : nullptr;
+    if ( csv ) std::fprintf( csv, "block,id,deposit,staked,liquid,supply,buffer,price\n" );
+
+    sx::engine::state state( self );
+    divergence div;
+    std::vector<uint64_t> touched;
+    uint32_t block = header->count ? events[0].block : 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    for ( uint64_t i = 0; i < header->count; ++i ) {
+        const event& e = events[i];
+        if ( e.block != block ) {
+            if ( csv ) write_curves( csv, state, touched, block );
+            touched.clear();
+            block = e.block;
+        }
+
+        uint64_t id = 0;
+        switch ( e.type ) {
+            case event_type::transfer: {
+                bool ignored = false;
+                const auto result = state.on_transfer( e.name, e.sym, e.a[0], e.burn, e.block, ignored );
+                if ( ignored ) break;
+                if ( result.err != sx::math::error::none ) {
+                    ++div.rejected;
+                    if ( !div.first_block ) div.first_block = e.block;
+                }
+                const auto* v = state.find( e.sym );
+                if ( !v ) v = state.find_by_supply( e.sym );
+                id = v->id;
+                break;
+            }
+            case event_type::vault: {
+                auto* v = state.find( e.sym );
+                if ( !v ) {
+                    state.insert( { e.sym, e.sym2, e.name, e.a[0], e.a[1], e.a[2], e.a[3], e.a[4], e.block } );
+                } else {
+                    ++div.compared;
+                    const int64_t d_deposit = abs_diff( v->deposit, e.a[0] );
+                    const int64_t d_supply = abs_diff( v->supply, e.a[2] );
+                    const int64_t d_buffer = abs_diff( v->buffer, e.a[3] );
+                    if ( d_deposit || d_supply || d_buffer || v->staked != e.a[1] ) {
+                        ++div.mismatched;
+                        if ( !div.first_block ) div.first_block = e.block;
+                    }
+                    if ( d_deposit > div.max_deposit ) div.max_deposit = d_deposit;
+                    if ( d_supply > div.max_supply ) div.max_supply = d_supply;
+                    if ( d_buffer > div.max_buffer ) div.max_buffer = d_buffer;
+                    if ( resync ) {
+                        v->deposit = e.a[0];
+                        v->staked = e.a[1];
+                        v->supply = e.a[2];
+                        v->buffer = e.a[3];
+                        v->max_buffer = e.a[4];
+                    }
+                }
+                id = e.sym;
+                break;
+            }
+            case event_type::update: {
+                auto* v = state.find( e.sym );
+                if ( !v ) break;
+                const int64_t buffer = v->account != self ? v->buffer : 0;
+                const int64_t balance = e.flags ? e.a[0] - e.a[1] - buffer : e.a[0];
+                state.update( *v, balance, e.a[1], e.block );
+                id = e.sym;
+                break;
+            }
+            case event_type::setbuffer: {
+                auto* v = state.find( e.sym );
+                if ( !v ) break;
+                state.setbuffer( *v, e.a[0] );
+                id = e.sym;
+                break;
+            }
+        }
+        if ( id && ( touched.empty() || touched.back() != id ) ) {
+            bool found = false;
+            for ( const auto t : touched ) found |= t == id;
+            if ( !found ) touched.push_back( id );
+        }
+    }
+    if ( csv ) {
+        write_curves( csv, state, touched, block );
+        std::fclose( csv );
+    }
+    const double seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+
+    std::printf( "events: %llu in %.3fs (%.1fM events/s)\n", (unsigned long long) header->count, seconds, seconds > 0 ? header->count / seconds / 1e6 : 0 );
+    std::printf( "vault rows compared: %llu, mismatched: %llu, rejected transfers: %llu\n",
+        (unsigned long long) div.compared, (unsigned long long) div.mismatched, (unsigned long long) div.rejected );
+    std::printf( "max divergence: deposit %lld, supply %lld, buffer %lld (first at block %u)\n",
+        (long long) div.max_deposit, (long long) div.max_supply, (long long) div.max_buffer, div.first_block );
+    for ( const auto& v : state.vaults() ) {
+        std::printf( "%s: deposit %lld staked %lld supply %lld buffer %lld\n", from_symbol_code( v.id ).c_str(),
+            (long long) v.deposit, (long long) v.staked, (long long) v.supply, (long long) v.buffer );
+    }
+
+    munmap( data, st.st_size );
+    close( fd );
+    return div.mismatched || div.rejected ? 2 : 0;
+}
+
+} // namespace
+
+int main( int argc, char** argv )
+{
+    if ( argc >= 4 && !std::strcmp( argv[1], "import" ) ) return import( argv[2], argv[3], argc >= 5 ? argv[4] : "vaults.sx" );
+    if ( argc >= 3 && !std::strcmp( argv[1], "run" ) ) {
+        const char* output = nullptr;
+        bool resync = false;
+        for ( int i = 3; i < argc; ++i ) {
+            if ( !std::strcmp( argv[i], "--resync" ) ) resync = true;
+            else output = argv[i];
+        }
+        return run( argv[2], output, resync );
+    }
+    std::fprintf( stderr, "usage: replay import <traces.jsonl> <events.bin> [self]\n       replay run <events.bin> [curves.csv] [--resync]\n" );
+    return 1;
+}
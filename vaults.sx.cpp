@@ -29,14 +29,39 @@ void sx::vaults::update( const symbol_code id )
         staked.amount += get_eos_refund( account );
     }
 
+    // hot buffer is held by contract until swept to vault account
+    const asset buffer = account != get_self() ? value_or_zero( vault.buffer, vault.deposit.get_extended_symbol() ).quantity : asset{ 0, sym };
+
     // update balance
     _vault.modify( vault, get_self(), [&]( auto& row ) {
-        row.deposit.quantity = balance + staked;
+        row.deposit.quantity = balance + staked + buffer;
         row.staked.quantity = staked;
         row.last_updated = current_time_point();
     });
 }
 
+[[eosio::action]]
+void sx::vaults::setbuffer( const symbol_code id, const asset max_buffer )
+{
+    require_auth( get_self() );
+    sx::vaults::vault_table _vault( get_self(), get_self().value );
+
+    auto& vault = _vault.get( id.raw(), "vault does not exist" );
+
+    // input validation
+    check( max_buffer.is_valid(), "max_buffer is invalid" );
+    check( max_buffer.symbol == vault.deposit.quantity.symbol, "max_buffer symbol does not match deposit" );
+    check( max_buffer.amount >= 0, "max_buffer must be non-negative" );
+
+    // buffer must be set along with max_buffer (binary extension)
+    const extended_asset buffer = value_or_zero( vault.buffer, vault.deposit.get_extended_symbol() );
+
+    _vault.modify( vault, get_self(), [&]( auto& row ) {
+        row.buffer.emplace( buffer );
+        row.max_buffer.emplace( max_buffer, vault.deposit.contract );
+    });
+}
+
 int64_t sx::vaults::get_eos_refund( const name owner )
 {
     eosiosystem::refunds_table _refunds( "eosio"_n, owner.value );
@@ -65,7 +90,7 @@ int64_t sx::vaults::get_eos_rex_fund( const name owner )
  * Notify contract when any token transfer notifiers relay contract
  */
 [[eosio::on_notify("*::transfer")]]
-void sx::vaults::on_transfer( const name from, const name to, const asset quantity, const string memo )
+void sx::vaults::on_transfer( const name from, const name to, const asset quantity, const string& memo )
 {
     // authenticate incoming `from` account
     require_auth( from );
@@ -91,31 +116,43 @@ void sx::vaults::on_transfer( const name from, const name to, const asset quanti
     if ( deposit_itr != _vault.end() ) {
         // input validation
         check( contract == deposit_itr->deposit.contract, "deposit token contract does not match" );
-        const symbol_code id = deposit_itr->deposit.quantity.symbol.code();
         const name account = deposit_itr->account;
 
         // calculate issuance supply token by providing balance
-        const extended_asset out = calculate_issue( id, quantity );
+        const extended_asset out = get_issue_quote( get_self(), quantity );
 
-        // update internal balance & supply
+        // hot buffer (rows without buffer sweep every deposit)
+        const extended_asset zero = { 0, deposit_itr->deposit.get_extended_symbol() };
+        extended_asset buffer = value_or_zero( deposit_itr->buffer, zero.get_extended_symbol() );
+        const extended_asset max_buffer = value_or_zero( deposit_itr->max_buffer, zero.get_extended_symbol() );
+
+        // (OPTIONAL) accumulate funds in hot buffer, sweep to vault account once threshold is exceeded
+        extended_asset sweep = zero;
+        if ( account != get_self() ) sweep.quantity.amount = sx::math::sweep( buffer.quantity.amount, max_buffer.quantity.amount, quantity.amount );
+
+        // update internal balance, supply & buffer
         _vault.modify( deposit_itr, get_self(), [&]( auto& row ) {
             row.deposit.quantity += quantity;
             row.supply += out;
             row.last_updated = current_time_point();
+            row.buffer.emplace( buffer );
+            row.max_buffer.emplace( max_buffer );
         });
 
-        // (OPTIONAL) send funds to vault account
-        if ( account != get_self() ) transfer( get_self(), account, { quantity, contract }, get_self().to_string() );
+        // outgoing transfer memo
+        const string self_memo = get_self().to_string();
+
+        // (OPTIONAL) send buffered funds to vault account
+        if ( sweep.quantity.amount ) transfer( get_self(), account, sweep, self_memo );
 
         // issue & transfer to sender
         issue( out, "issue" );
-        transfer( get_self(), from, out, get_self().to_string() );
+        transfer( get_self(), from, out, self_memo );
 
     // withdraw - handle retire (ex: SXEOS => EOS)
     } else if ( supply_itr != _vault_by_supply.end() ) {
         // input validation
         check( contract == supply_itr->supply.contract, "supply token contract does not match" );
-        const symbol_code id = supply_itr->deposit.quantity.symbol.code();
         const name account = supply_itr->account;
 
         // retire - burn vault tokens (ex: SXEOS => 🔥)
@@ -126,22 +163,36 @@ void sx::vaults::on_transfer( const name from, const name to, const asset quanti
             });
         // redeem - calculate amount from retiring supply token
         } else {
-            const extended_asset out = calculate_retire( id, quantity );
+            const extended_asset out = get_retire_quote( get_self(), quantity );
+
+            // hot buffer (rows without buffer retrieve every redeem)
+            const extended_asset zero = { 0, out.get_extended_symbol() };
+            extended_asset buffer = value_or_zero( supply_itr->buffer, zero.get_extended_symbol() );
+            const extended_asset max_buffer = value_or_zero( supply_itr->max_buffer, zero.get_extended_symbol() );
 
-            // update internal deposit & supply
+            // (OPTIONAL) serve from hot buffer, retrieve remaining funds from vault account
+            extended_asset retrieve = zero;
+            if ( account != get_self() ) retrieve.quantity.amount = sx::math::retrieve( buffer.quantity.amount, out.quantity.amount );
+
+            // update internal deposit, supply & buffer
             _vault_by_supply.modify( supply_itr, get_self(), [&]( auto& row ) {
                 row.deposit -= out;
+                row.buffer.emplace( buffer );
+                row.max_buffer.emplace( max_buffer );
                 row.supply.quantity -= quantity;
                 row.last_updated = current_time_point();
 
                 // deposit (liquid balance) must be equal or above staked amount
-                check( row.deposit >= row.staked, "maximum withdraw is " + (row.deposit.quantity - row.staked.quantity).to_string() + ", please wait for deposit balance to equal or exceed staked amount");
+                if ( row.deposit < row.staked ) check( false, "maximum withdraw is " + (row.deposit.quantity - row.staked.quantity).to_string() + ", please wait for deposit balance to equal or exceed staked amount");
             });
+            // outgoing transfer memo
+            const string self_memo = get_self().to_string();
+
             // (OPTIONAL) retrieve funds from vault account
-            if ( account != get_self() ) transfer( account, get_self(), out, get_self().to_string() );
+            if ( retrieve.quantity.amount ) transfer( account, get_self(), retrieve, self_memo );
 
             // send underlying assets to sender
-            transfer( get_self(), from, out, get_self().to_string() );
+            transfer( get_self(), from, out, self_memo );
         }
 
         // retire vault liquidity supply token
@@ -187,67 +238,62 @@ void sx::vaults::setvault( const extended_symbol deposit, const symbol_code supp
 
     // create/modify vault
     auto itr = _vault.find( id.raw() );
-    if ( itr == _vault.end() ) _vault.emplace( get_self(), insert );
-    else _vault.modify( itr, get_self(), insert );
+    if ( itr == _vault.end() ) {
+        _vault.emplace( get_self(), [&]( auto & row ) {
+            insert( row );
+            row.buffer.emplace( 0, deposit );
+            row.max_buffer.emplace( 0, deposit );
+        });
+    } else {
+        const extended_asset zero = { 0, deposit };
+        extended_asset buffer = value_or_zero( itr->buffer, itr->deposit.get_extended_symbol() );
+        extended_asset max_buffer = value_or_zero( itr->max_buffer, deposit );
+
+        // changing deposit contract requires an empty buffer
+        if ( itr->deposit.get_extended_symbol() != deposit ) {
+            check( buffer.quantity.amount == 0, "buffer must be empty to change deposit contract" );
+            buffer = zero;
+            max_buffer = zero;
+        }
+        // buffer funds are already held by contract when vault account is itself
+        if ( account == get_self() ) buffer = zero;
+
+        _vault.modify( itr, get_self(), [&]( auto & row ) {
+            insert( row );
+            row.buffer.emplace( buffer );
+            row.max_buffer.emplace( max_buffer );
+        });
+    }
 
     // update deposit & staked asset balances
     update( id );
 }
 
-extended_asset sx::vaults::calculate_issue( const symbol_code id, const asset payment )
-{
-    sx::vaults::vault_table _vault( get_self(), get_self().value );
-    const auto vault = _vault.get( id.raw(), "id does not exists in vault" );
-    const int64_t ratio = 10000;
-
-    // initialize vault supply
-    if ( vault.supply.quantity.amount == 0 ) return { payment.amount * ratio, vault.supply.get_extended_symbol() };
-
-    // issue & redeem supply calculation
-    // calculations based on fill REX order
-    // https://github.com/EOSIO/eosio.contracts/blob/f6578c45c83ec60826e6a1eeb9ee71de85abe976/contracts/eosio.system/src/rex.cpp#L775-L779
-    const int64_t S0 = vault.deposit.quantity.amount; // vault
-    const int64_t S1 = S0 + payment.amount; // payment
-    const int64_t R0 = vault.supply.quantity.amount; // supply
-    const int64_t R1 = (uint128_t(S1) * R0) / S0;
-
-    return { R1 - R0, vault.supply.get_extended_symbol() };
-}
-
-extended_asset sx::vaults::calculate_retire( const symbol_code id, const asset payment )
+extended_asset sx::vaults::value_or_zero( const binary_extension<extended_asset>& value, const extended_symbol& sym )
 {
-    sx::vaults::vault_table _vault( get_self(), get_self().value );
-    const auto vault = _vault.get( id.raw(), "id does not exists in vault" );
-
-    // issue & redeem supply calculation
-    // calculations based on add to REX pool
-    // https://github.com/EOSIO/eosio.contracts/blob/f6578c45c83ec60826e6a1eeb9ee71de85abe976/contracts/eosio.system/src/rex.cpp#L772
-    const int64_t S0 = vault.deposit.quantity.amount;
-    const int64_t R0 = vault.supply.quantity.amount;
-    const int64_t p  = (uint128_t(payment.amount) * S0) / R0;
-
-    return { p, vault.deposit.get_extended_symbol() };
+    if ( value.has_value() ) return value.value();
+    return { 0, sym };
 }
 
-void sx::vaults::create( const extended_symbol value )
+void sx::vaults::create( const extended_symbol& value )
 {
     eosio::token::create_action create( value.get_contract(), { value.get_contract(), "active"_n });
     create.send( get_self(), asset{ asset_max, value.get_symbol() } );
 }
 
-void sx::vaults::issue( const extended_asset value, const string memo )
+void sx::vaults::issue( const extended_asset& value, const string& memo )
 {
     eosio::token::issue_action issue( value.contract, { get_self(), "active"_n });
     issue.send( get_self(), value.quantity, memo );
 }
 
-void sx::vaults::retire( const extended_asset value, const string memo )
+void sx::vaults::retire( const extended_asset& value, const string& memo )
 {
     eosio::token::retire_action retire( value.contract, { get_self(), "active"_n });
     retire.send( value.quantity, memo );
 }
 
-void sx::vaults::transfer( const name from, const name to, const extended_asset value, const string memo )
+void sx::vaults::transfer( const name from, const name to, const extended_asset& value, const string& memo )
 {
     eosio::token::transfer_action transfer( value.contract, { from, "active"_n });
     transfer.send( from, to, value.quantity, memo );
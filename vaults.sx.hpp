@@ -3,9 +3,12 @@
 #include <eosio/eosio.hpp>
 #include <eosio/asset.hpp>
 #include <eosio/singleton.hpp>
+#include <eosio/binary_extension.hpp>
 
 #include <optional>
 
+#include "vaults.sx.math.hpp"
+
 using namespace eosio;
 using namespace std;
 
@@ -26,6 +29,8 @@ public:
      * - `{asset} supply` - vault active supply
      * - `{name} account` - account to/from deposit balance
      * - `{time_point_sec} last_updated` - last updated timestamp
+     * - `{asset} buffer` - (optional) hot buffer held by contract before sweeping to vault `account`
+     * - `{asset} max_buffer` - (optional) buffer threshold which triggers a sweep to vault `account`
      *
      * ### example
      *
@@ -34,8 +39,10 @@ public:
      *   "deposit": {"quantity": "2000.0000 EOS", "contract": "eosio.token"},
      *   "staked": {"quantity": "800.0000 EOS", "contract": "eosio.token"},
      *   "supply": {"quantity": "1000000.0000 SXEOS", "contract": "token.sx"},
-     *   "account": "vaults.sx",
-     *   "last_updated": "2020-11-23T00:00:00"
+     *   "account": "flash.sx",
+     *   "last_updated": "2020-11-23T00:00:00",
+     *   "buffer": {"quantity": "25.0000 EOS", "contract": "eosio.token"},
+     *   "max_buffer": {"quantity": "100.0000 EOS", "contract": "eosio.token"}
      * }
      * ```
      */
@@ -45,6 +52,8 @@ public:
         extended_asset          supply;
         name                    account;
         time_point_sec          last_updated;
+        binary_extension<extended_asset> buffer;
+        binary_extension<extended_asset> max_buffer;
 
         uint64_t primary_key() const { return deposit.quantity.symbol.code().raw(); }
         uint64_t by_supply() const { return supply.quantity.symbol.code().raw(); }
@@ -95,26 +104,84 @@ public:
     [[eosio::action]]
     void update( const symbol_code id );
 
+    /**
+     * ## ACTION `setbuffer`
+     *
+     * Set vault hot buffer threshold, deposits accumulate in `vaults.sx` until threshold is exceeded
+     *
+     * - **authority**: `get_self()`
+     *
+     * ### params
+     *
+     * - `{symbol_code} id` - deposit symbol
+     * - `{asset} max_buffer` - maximum buffer held before sweeping to vault `account`
+     *
+     * ### Example
+     *
+     * ```bash
+     * $ cleos push action vaults.sx setbuffer '["EOS", "100.0000 EOS"]' -p vaults.sx
+     * ```
+     */
+    [[eosio::action]]
+    void setbuffer( const symbol_code id, const asset max_buffer );
+
     /**
      * Notify contract when any token transfer notifiers relay contract
      */
     [[eosio::on_notify("*::transfer")]]
-    void on_transfer( const name from, const name to, const asset quantity, const std::string memo );
+    void on_transfer( const name from, const name to, const asset quantity, const std::string& memo );
+
+    /**
+     * Get supply issued by depositing `payment` into vault of `code` contract
+     *
+     * @param code - vaults contract account (ex: `vaults.sx`)
+     * @param payment - deposit quantity (ex: `1.0000 EOS`)
+     * @return supply quantity (ex: `10000.0000 SXEOS`)
+     */
+    static extended_asset get_issue_quote( const name code, const asset payment )
+    {
+        vault_table _vault( code, code.value );
+        const auto& vault = _vault.get( payment.symbol.code().raw(), "vault does not exist" );
+
+        const auto out = sx::math::quote_issue( payment.amount, vault.deposit.quantity.amount, vault.supply.quantity.amount );
+        check( out.err == sx::math::error::none, sx::math::message( out.err ) );
+
+        return { out.amount, vault.supply.get_extended_symbol() };
+    }
+
+    /**
+     * Get deposit redeemed by retiring `payment` supply from vault of `code` contract
+     *
+     * @param code - vaults contract account (ex: `vaults.sx`)
+     * @param payment - supply quantity (ex: `10000.0000 SXEOS`)
+     * @return deposit quantity (ex: `1.0000 EOS`)
+     */
+    static extended_asset get_retire_quote( const name code, const asset payment )
+    {
+        vault_table _vault( code, code.value );
+        auto _vault_by_supply = _vault.get_index<"bysupply"_n>();
+        const auto& vault = _vault_by_supply.get( payment.symbol.code().raw(), "vault does not exist" );
+
+        const auto out = sx::math::quote_retire( payment.amount, vault.deposit.quantity.amount, vault.supply.quantity.amount );
+        check( out.err == sx::math::error::none, sx::math::message( out.err ) );
+
+        return { out.amount, vault.deposit.get_extended_symbol() };
+    }
 
     // static actions
     using setvault_action = eosio::action_wrapper<"setvault"_n, &sx::vaults::setvault>;
     using update_action = eosio::action_wrapper<"update"_n, &sx::vaults::update>;
+    using setbuffer_action = eosio::action_wrapper<"setbuffer"_n, &sx::vaults::setbuffer>;
 
 private:
     // eosio.token helper
-    void transfer( const name from, const name to, const extended_asset value, const string memo );
-    void create( const extended_symbol value );
-    void retire( const extended_asset value, const string memo );
-    void issue( const extended_asset value, const string memo );
-
-    // vault
-    extended_asset calculate_issue( const symbol_code id, const asset payment );
-    extended_asset calculate_retire( const symbol_code id, const asset payment );
+    void transfer( const name from, const name to, const extended_asset& value, const string& memo );
+    void create( const extended_symbol& value );
+    void retire( const extended_asset& value, const string& memo );
+    void issue( const extended_asset& value, const string& memo );
+
+    // buffer (binary extension) helper, missing value is zero
+    static extended_asset value_or_zero( const binary_extension<extended_asset>& value, const extended_symbol& sym );
 
     // update balance/staked/deposit/REX
     int64_t get_eos_voters_staked( const name owner );
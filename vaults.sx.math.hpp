@@ -0,0 +1,164 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Vault pricing math
+ *
+ * Plain integer functions with no EOSIO dependencies, shared by the contract and native (host compiled) tooling
+ * so that off-chain replays & quotes match on-chain results exactly.
+ *
+ * Both calculations truncate, rounding in favour of the vault (existing holders) and never the caller.
+ * `issue` & `retire` do not validate inputs, `quote_issue` & `quote_retire` apply the contract guards.
+ */
+namespace sx::math {
+
+__extension__ typedef unsigned __int128 uint128_t;
+
+// maximum asset amount (1^62 - 1)
+static constexpr int64_t asset_max = (1LL << 62) - 1;
+
+// initial vault price ratio (1 deposit => 10,000 supply)
+static constexpr int64_t ratio = 10000;
+
+enum class error : uint8_t {
+    none,
+    max_initial_supply,
+    no_deposit,
+    max_supply,
+    deposit_too_small,
+    no_supply,
+    redeem_too_small,
+    max_withdraw,
+};
+
+inline const char* message( const error err )
+{
+    switch ( err ) {
+        case error::none: return "";
+        case error::max_initial_supply: return "deposit exceeds maximum initial supply";
+        case error::no_deposit: return "vault has no deposit";
+        case error::max_supply: return "deposit exceeds maximum supply";
+        case error::deposit_too_small: return "deposit amount too small";
+        case error::no_supply: return "vault has no supply";
+        case error::redeem_too_small: return "redeem amount too small";
+        case error::max_withdraw: return "maximum withdraw exceeded";
+    }
+    return "unknown error";
+}
+
+struct quote {
+    int64_t amount;
+    error   err;
+};
+
+/**
+ * Calculate supply issued by depositing `payment` into vault
+ *
+ * @param payment - deposit amount
+ * @param deposit - vault deposit amount
+ * @param supply - vault supply amount
+ * @return supply amount to issue
+ */
+inline int64_t issue( const int64_t payment, const int64_t deposit, const int64_t supply )
+{
+    // initialize vault supply
+    if ( supply == 0 ) return payment * ratio;
+
+    // issue & redeem supply calculation
+    // calculations based on fill REX order
+    // https://github.com/EOSIO/eosio.contracts/blob/f6578c45c83ec60826e6a1eeb9ee71de85abe976/contracts/eosio.system/src/rex.cpp#L775-L779
+    const int64_t S0 = deposit; // vault
+    const int64_t S1 = S0 + payment; // payment
+    const int64_t R0 = supply; // supply
+    const int64_t R1 = (uint128_t(S1) * R0) / S0;
+
+    return R1 - R0;
+}
+
+/**
+ * Calculate deposit redeemed by retiring `payment` supply from vault
+ *
+ * @param payment - supply amount
+ * @param deposit - vault deposit amount
+ * @param supply - vault supply amount
+ * @return deposit amount to redeem
+ */
+inline int64_t retire( const int64_t payment, const int64_t deposit, const int64_t supply )
+{
+    // issue & redeem supply calculation
+    // calculations based on add to REX pool
+    // https://github.com/EOSIO/eosio.contracts/blob/f6578c45c83ec60826e6a1eeb9ee71de85abe976/contracts/eosio.system/src/rex.cpp#L772
+    const int64_t S0 = deposit;
+    const int64_t R0 = supply;
+    const int64_t p  = (uint128_t(payment) * S0) / R0;
+
+    return p;
+}
+
+/**
+ * Calculate supply issued by depositing `payment` into vault, rejecting inputs the contract rejects
+ */
+inline quote quote_issue( const int64_t payment, const int64_t deposit, const int64_t supply )
+{
+    // issued supply must remain within maximum asset amount
+    if ( supply == 0 ) {
+        if ( payment > asset_max / ratio ) return { 0, error::max_initial_supply };
+    } else {
+        if ( deposit <= 0 ) return { 0, error::no_deposit };
+        if ( uint128_t(deposit + payment) * supply > uint128_t(asset_max) * deposit ) return { 0, error::max_supply };
+    }
+
+    // truncated issuance must not round down to zero
+    const int64_t out = issue( payment, deposit, supply );
+    if ( out <= 0 ) return { 0, error::deposit_too_small };
+
+    return { out, error::none };
+}
+
+/**
+ * Calculate deposit redeemed by retiring `payment` supply from vault, rejecting inputs the contract rejects
+ */
+inline quote quote_retire( const int64_t payment, const int64_t deposit, const int64_t supply )
+{
+    if ( supply <= 0 ) return { 0, error::no_supply };
+
+    // truncated redemption must not round down to zero
+    const int64_t out = retire( payment, deposit, supply );
+    if ( out <= 0 ) return { 0, error::redeem_too_small };
+
+    return { out, error::none };
+}
+
+/**
+ * Add deposit `amount` to hot `buffer`, sweeping the whole buffer once it exceeds `max_buffer`
+ *
+ * @return amount to transfer to vault account
+ */
+inline int64_t sweep( int64_t& buffer, const int64_t max_buffer, const int64_t amount )
+{
+    buffer += amount;
+    if ( buffer <= max_buffer ) return 0;
+
+    const int64_t out = buffer;
+    buffer = 0;
+    return out;
+}
+
+/**
+ * Serve redeem `amount` from hot `buffer`
+ *
+ * @return remaining amount to retrieve from vault account
+ */
+inline int64_t retrieve( int64_t& buffer, const int64_t amount )
+{
+    if ( amount <= buffer ) {
+        buffer -= amount;
+        return 0;
+    }
+    const int64_t out = amount - buffer;
+    buffer = 0;
+    return out;
+}
+
+} // namespace sx::math